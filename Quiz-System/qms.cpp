@@ -1,10 +1,38 @@
 // Header Files
+#ifdef _WIN32
+#define _CRT_RAND_S   // Declares rand_s in <stdlib.h>, must come before any other include
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>  // for MoveFileExA
+#endif
 #include <sstream>
 #include <iostream>
 #include <string>
 #include <fstream>
 #include <cstdlib> 
+#include <cstdio>   // for remove
 #include <iomanip>  // for setw and setfill
+#include <cstring>  // for memcpy
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <map>
+#include <chrono>
+
+// std::thread needs a toolchain with C++11 thread support (MSVC, or MinGW-w64 with the posix
+// thread model). Without it, or when built with -DQMS_NO_THREADS, passwords are hashed one by one.
+#if defined(__GLIBCXX__) && !defined(_GLIBCXX_HAS_GTHREADS) && !defined(QMS_NO_THREADS)
+#define QMS_NO_THREADS
+#endif
+
+#ifndef QMS_NO_THREADS
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#endif
 
 using namespace std;
 
@@ -110,24 +138,433 @@ public:
     }
 };
 
+// Minimal SHA-256, used as the PRF for the password KDF
+class Sha256 {
+public:
+    Sha256() { reset(); }
+
+    void reset();
+    void update(const unsigned char* data, size_t len);
+    void update(const string& data) { update(reinterpret_cast<const unsigned char*>(data.data()), data.size()); }
+    void final(unsigned char digest[32]);
+
+private:
+    uint32_t state[8];
+    unsigned char buffer[64];
+    size_t bufferLen;
+    uint64_t totalLen;
+
+    void transform(const unsigned char block[64]);
+};
+
+#ifndef QMS_NO_THREADS
+// Fixed-size pool of worker threads that hashes passwords in parallel, used when many
+// entries in users.txt have to be rehashed at once
+class HashingPool {
+public:
+    explicit HashingPool(unsigned numThreads);
+    ~HashingPool();
+
+    future<string> submit(const string& password);
+
+private:
+    vector<thread> workers;
+    queue<function<void()> > tasks;
+    mutex taskLock;
+    condition_variable taskReady;
+    bool stopping;
+
+    void run();
+};
+#endif
+
+// Short-lived cache of verified logins so logging in again does not pay for the KDF.
+// Only a keyed tag of the username and password is kept, never the password or its stored hash.
+// A cache hit does not read users.txt, so an account edited or removed there can still
+// log in with its old password until the entry expires.
+class LoginCache {
+public:
+    explicit LoginCache(int ttlSeconds);
+
+    bool lookup(const string& username, const string& password, User& user);
+    void store(const User& user, const string& password);
+
+private:
+    struct Login {
+        string tag;
+        User user;
+        chrono::steady_clock::time_point expiry;
+    };
+
+    map<string, Login> logins;
+    string secret;
+    int ttlSeconds;
+
+    string tagFor(const string& username, const string& password) const;
+};
+
+// Function prototypes for password hashing
+int envSetting(const char* name, int fallback);
+string randomBytes(size_t count);
+string toHex(const string& bytes);
+string fromHex(const string& hex);
+string pbkdf2Sha256(const string& password, const string& salt, int iterations);
+string hashPassword(const string& password);
+bool verifyPassword(const string& password, const string& stored);
+bool constantTimeEquals(const string& a, const string& b);
+bool isLegacyHash(const string& stored);
+string unhashLegacy(const string& stored);
+
 // Function prototypes for file I/O operations
 bool writeUserData(const User& user, const string& filename);
 User readUserData(const string& filename, const string& username, const string& password);
+int migrateUserData(const string& filename);
+bool saveUserData(const string& filename, const string& content);
+bool replaceUserLines(const string& filename, const map<string, string>& replacements);
 bool writeQuizData(const Quiz& quiz, const Question* questions, const string& courseID);
 Quiz readQuizData(const string& filename, const string& courseID, const string& quizName);
 bool quizExists(const string& courseID, const string& quizName);
 void showQuiz(const string& courseID, const string& quizName);
 void displayQuiz(const Quiz& quiz); // Separate function to display a Quiz
+string checkpointFilename(const string& courseID, const string& username, const string& quizName);
+unsigned long quizFingerprint(const Quiz& quiz);
+int readCheckpoint(const string& filename, const Quiz& quiz, int answers[]);
+
+// SHA-256 round constants
+static const uint32_t sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+void Sha256::reset() {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(state, init, sizeof(state));
+    bufferLen = 0;
+    totalLen = 0;
+}
+
+void Sha256::transform(const unsigned char block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+               (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void Sha256::update(const unsigned char* data, size_t len) {
+    totalLen += len;
+    while (len > 0) {
+        size_t take = 64 - bufferLen;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(buffer + bufferLen, data, take);
+        bufferLen += take;
+        data += take;
+        len -= take;
+        if (bufferLen == 64) {
+            transform(buffer);
+            bufferLen = 0;
+        }
+    }
+}
+
+void Sha256::final(unsigned char digest[32]) {
+    uint64_t bits = totalLen * 8;
+    unsigned char pad = 0x80;
+    update(&pad, 1);
+    pad = 0;
+    while (bufferLen != 56) {
+        update(&pad, 1);
+    }
+    unsigned char length[8];
+    for (int i = 0; i < 8; ++i) {
+        length[i] = static_cast<unsigned char>(bits >> (56 - i * 8));
+    }
+    update(length, 8);
+
+    for (int i = 0; i < 8; ++i) {
+        digest[i * 4] = static_cast<unsigned char>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<unsigned char>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<unsigned char>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<unsigned char>(state[i]);
+    }
+}
+
+// Reads a positive integer setting from the environment, e.g. QMS_KDF_ITERATIONS
+int envSetting(const char* name, int fallback) {
+    const char* value = getenv(name);
+    if (value == NULL) {
+        return fallback;
+    }
+    int parsed = atoi(value);
+    return parsed > 0 ? parsed : fallback;
+}
+
+// Reads from the operating system's CSPRNG. std::random_device is not used because
+// MinGW's libstdc++ before GCC 9.2 implements it as an mt19937 with a fixed seed.
+string randomBytes(size_t count) {
+    string bytes(count, '\0');
+#ifdef _WIN32
+    for (size_t i = 0; i < count; i += 4) {
+        unsigned int value;
+        if (rand_s(&value) != 0) {
+            cerr << "Error: Could not read random bytes from rand_s" << endl;
+            exit(1);
+        }
+        for (size_t j = 0; j < 4 && i + j < count; ++j) {
+            bytes[i + j] = static_cast<char>(value >> (j * 8));
+        }
+    }
+#else
+    ifstream urandom("/dev/urandom", ios::binary);
+    if (!urandom.read(&bytes[0], count)) {
+        cerr << "Error: Could not read random bytes from /dev/urandom" << endl;
+        exit(1);
+    }
+#endif
+    return bytes;
+}
+
+string toHex(const string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(bytes[i]);
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0f];
+    }
+    return hex;
+}
+
+string fromHex(const string& hex) {
+    string bytes;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes += static_cast<char>(strtol(hex.substr(i, 2).c_str(), NULL, 16));
+    }
+    return bytes;
+}
+
+// PBKDF2-HMAC-SHA256 producing a single 32-byte block.
+// The padded HMAC key is hashed once up front and the midstates are copied on every
+// iteration, which halves the number of SHA-256 compressions per iteration.
+string pbkdf2Sha256(const string& password, const string& salt, int iterations) {
+    unsigned char key[64] = {0};
+    if (password.size() > 64) {
+        Sha256 keyHash;
+        keyHash.update(password);
+        keyHash.final(key);
+    } else {
+        memcpy(key, password.data(), password.size());
+    }
+
+    unsigned char ipad[64], opad[64];
+    for (int i = 0; i < 64; ++i) {
+        ipad[i] = key[i] ^ 0x36;
+        opad[i] = key[i] ^ 0x5c;
+    }
+    Sha256 inner, outer;
+    inner.update(ipad, 64);
+    outer.update(opad, 64);
+
+    // U1 = HMAC(password, salt || INT(1))
+    static const unsigned char blockIndex[4] = {0, 0, 0, 1};
+    unsigned char u[32], result[32];
+    Sha256 ctx = inner;
+    ctx.update(salt);
+    ctx.update(blockIndex, 4);
+    ctx.final(u);
+    ctx = outer;
+    ctx.update(u, 32);
+    ctx.final(u);
+    memcpy(result, u, 32);
+
+    // Un = HMAC(password, Un-1), result = U1 ^ U2 ^ ... ^ Un
+    for (int n = 1; n < iterations; ++n) {
+        ctx = inner;
+        ctx.update(u, 32);
+        ctx.final(u);
+        ctx = outer;
+        ctx.update(u, 32);
+        ctx.final(u);
+        for (int i = 0; i < 32; ++i) {
+            result[i] ^= u[i];
+        }
+    }
+
+    return string(reinterpret_cast<const char*>(result), 32);
+}
+
+// Produces a stored password of the form pbkdf2$<iterations>$<salt hex>$<hash hex>.
+// The cost is read from QMS_KDF_ITERATIONS and recorded per entry, so it can be
+// raised later without invalidating existing passwords.
+string hashPassword(const string& password) {
+    int iterations = envSetting("QMS_KDF_ITERATIONS", 100000);
+    string salt = randomBytes(16);
+    ostringstream stored;
+    stored << "pbkdf2$" << iterations << "$" << toHex(salt) << "$" << toHex(pbkdf2Sha256(password, salt, iterations));
+    return stored.str();
+}
+
+// Entries written before the KDF stored each password byte shifted by 3
+bool isLegacyHash(const string& stored) {
+    return stored.compare(0, 7, "pbkdf2$") != 0;
+}
+
+string unhashLegacy(const string& stored) {
+    string unhashed = stored;
+    for (size_t i = 0; i < unhashed.length(); ++i) {
+        unhashed[i] = unhashed[i] - 3;
+    }
+    return unhashed;
+}
+
+bool verifyPassword(const string& password, const string& stored) {
+    if (isLegacyHash(stored)) {
+        return password == unhashLegacy(stored);
+    }
+
+    istringstream fields(stored.substr(7));
+    string iterationText, saltHex, hashHex;
+    getline(fields, iterationText, '$');
+    getline(fields, saltHex, '$');
+    getline(fields, hashHex, '$');
+
+    int iterations = atoi(iterationText.c_str());
+    if (iterations <= 0) {
+        return false;
+    }
+
+    return constantTimeEquals(fromHex(hashHex), pbkdf2Sha256(password, fromHex(saltHex), iterations));
+}
+
+// Compares every byte so the time taken does not reveal where the strings differ
+bool constantTimeEquals(const string& a, const string& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    unsigned char diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+#ifndef QMS_NO_THREADS
+HashingPool::HashingPool(unsigned numThreads) : stopping(false) {
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    for (unsigned i = 0; i < numThreads; ++i) {
+        workers.push_back(thread(&HashingPool::run, this));
+    }
+}
+
+HashingPool::~HashingPool() {
+    {
+        lock_guard<mutex> guard(taskLock);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+
+future<string> HashingPool::submit(const string& password) {
+    shared_ptr<packaged_task<string()> > task = make_shared<packaged_task<string()> >(
+        bind(hashPassword, password));
+    future<string> result = task->get_future();
+    {
+        lock_guard<mutex> guard(taskLock);
+        tasks.push([task]() { (*task)(); });
+    }
+    taskReady.notify_one();
+    return result;
+}
+
+void HashingPool::run() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(taskLock);
+            taskReady.wait(guard, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = tasks.front();
+            tasks.pop();
+        }
+        task();
+    }
+}
+#endif
+
+LoginCache::LoginCache(int ttlSeconds) : secret(randomBytes(32)), ttlSeconds(ttlSeconds) {}
+
+// Keyed tag of the login, so the cache cannot be used to recover the password.
+// A single PBKDF2 iteration is HMAC-SHA256(secret, username:password || INT(1)).
+string LoginCache::tagFor(const string& username, const string& password) const {
+    return pbkdf2Sha256(secret, username + ":" + password, 1);
+}
+
+bool LoginCache::lookup(const string& username, const string& password, User& user) {
+    map<string, Login>::iterator it = logins.find(username);
+    if (it == logins.end()) {
+        return false;
+    }
+    if (chrono::steady_clock::now() >= it->second.expiry) {
+        logins.erase(it); // Login expired, verify again
+        return false;
+    }
+    if (!constantTimeEquals(it->second.tag, tagFor(username, password))) {
+        return false;
+    }
+    const User& cached = it->second.user;
+    user = User(cached.getUsername(), password, cached.getDesignation(), cached.getCourseID());
+    return true;
+}
+
+void LoginCache::store(const User& user, const string& password) {
+    Login login;
+    login.tag = tagFor(user.getUsername(), password);
+    login.user = User(user.getUsername(), "", user.getDesignation(), user.getCourseID()); // Drop the password
+    login.expiry = chrono::steady_clock::now() + chrono::seconds(ttlSeconds);
+    logins[user.getUsername()] = login;
+}
 
 // Implementation of writeUserData function (stores each user in a separate line)
 bool writeUserData(const User& user, const string& filename) {
     ofstream outfile(filename.c_str(), ios::app); // Open in append mode
 
-    string hash = user.getPassword();
-
-    for (int i = 0; i < hash.length(); ++i) {
-        hash[i] = hash[i] + 3;
-    }
+    string hash = hashPassword(user.getPassword());
 
     if (outfile.is_open()) {
         outfile << user.getUsername() << "," << hash << "," << user.getDesignation() << "," << user.getCourseID() << endl;
@@ -155,15 +592,21 @@ User readUserData(const string& filename, const string& username, const string&
         getline(iss, readdesignation, ',');
         getline(iss, readCourseID, ',');
 
-        string unhashed = readPassword;
+        // Only run the KDF for the matching username
+        if (username == readUsername && verifyPassword(password, readPassword)) {
+            infile.close();
 
-        for (int i = 0; i < unhashed.length(); ++i) {
-            unhashed[i] = unhashed[i] - 3;
-        }
+            // An old-style entry survived migration, replace it now that the password is known
+            if (isLegacyHash(readPassword)) {
+                cerr << "Warning: user " << readUsername << " had a reversible password, rehashing it" << endl;
+                map<string, string> upgraded;
+                upgraded[line] = readUsername + "," + hashPassword(password) + "," + readdesignation + "," + readCourseID;
+                if (!replaceUserLines(filename, upgraded)) {
+                    cerr << "Error: Could not rehash password for user " << readUsername << endl;
+                }
+            }
 
-        if (username == readUsername && password == unhashed) {
-            infile.close();
-            return User(string(readUsername.c_str()), string(unhashed.c_str()),
+            return User(string(readUsername.c_str()), password,
                         string(readdesignation.c_str()), string(readCourseID.c_str()));
         }
     }
@@ -172,6 +615,120 @@ User readUserData(const string& filename, const string& username, const string&
     return User("", "", "", ""); // Return empty User object if user not found
 }
 
+// Rehashes any entries still using the old shifted-byte scheme with the KDF.
+// The entries are hashed in parallel on a HashingPool (QMS_KDF_THREADS workers),
+// or one by one when built without thread support.
+// Returns the number of entries migrated.
+int migrateUserData(const string& filename) {
+    ifstream infile(filename.c_str());
+    if (!infile.is_open()) {
+        return 0; // No users yet
+    }
+
+    // Old line -> username, legacy password, designation and courseID
+    vector<string> lines, usernames, passwords, designations, courseIDs;
+    string line;
+    while (getline(infile, line)) {
+        istringstream iss(line);
+        string readUsername, readPassword, readdesignation, readCourseID;
+        getline(iss, readUsername, ',');
+        getline(iss, readPassword, ',');
+        getline(iss, readdesignation, ',');
+        getline(iss, readCourseID, ',');
+
+        if (!readUsername.empty() && isLegacyHash(readPassword)) {
+            lines.push_back(line);
+            usernames.push_back(readUsername);
+            passwords.push_back(readPassword);
+            designations.push_back(readdesignation);
+            courseIDs.push_back(readCourseID);
+        }
+    }
+    infile.close();
+
+    if (lines.empty()) {
+        return 0;
+    }
+
+#ifndef QMS_NO_THREADS
+    {
+        HashingPool pool(envSetting("QMS_KDF_THREADS", thread::hardware_concurrency()));
+        vector<future<string> > hashes;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            hashes.push_back(pool.submit(unhashLegacy(passwords[i])));
+        }
+        for (size_t i = 0; i < lines.size(); ++i) {
+            passwords[i] = hashes[i].get();
+        }
+    }
+#else
+    for (size_t i = 0; i < lines.size(); ++i) {
+        passwords[i] = hashPassword(unhashLegacy(passwords[i]));
+    }
+#endif
+
+    map<string, string> migrated;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        migrated[lines[i]] = usernames[i] + "," + passwords[i] + "," + designations[i] + "," + courseIDs[i];
+    }
+
+    if (!replaceUserLines(filename, migrated)) {
+        cerr << "Error: Could not migrate passwords in " << filename << endl;
+        return 0;
+    }
+    return static_cast<int>(lines.size());
+}
+
+// Replaces the contents of the users file without risking a half-written file.
+// The new content goes to <filename>.tmp first and is only moved over the original
+// once it has been written completely.
+bool saveUserData(const string& filename, const string& content) {
+    string tempFilename = filename + ".tmp";
+    ofstream writefile(tempFilename.c_str());
+    if (!writefile.is_open()) {
+        return false;
+    }
+    writefile << content;
+    writefile.close();
+    if (writefile.fail()) {
+        remove(tempFilename.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    // rename() will not replace an existing file on Windows
+    return MoveFileExA(tempFilename.c_str(), filename.c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(tempFilename.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+// Replaces lines of the users file that match a key in replacements with its value.
+// The file is read again right before it is replaced, so lines appended meanwhile by
+// writeUserData (e.g. a signup in another instance during a slow rehash) are kept.
+bool replaceUserLines(const string& filename, const map<string, string>& replacements) {
+    ifstream infile(filename.c_str());
+    if (!infile.is_open()) {
+        return false;
+    }
+
+    stringstream content;
+    string line;
+    bool replaced = false;
+    while (getline(infile, line)) {
+        map<string, string>::const_iterator it = replacements.find(line);
+        if (it != replacements.end()) {
+            line = it->second;
+            replaced = true;
+        }
+        content << line << endl;
+    }
+    infile.close();
+
+    return replaced && saveUserData(filename, content.str());
+}
+
 // Implementation of writeQuizData function 
 bool writeQuizData(const Quiz& quiz, const Question* questions, const string& courseID) {
     string quizFilename = courseID + "_" + quiz.name + ".txt";
@@ -279,6 +836,70 @@ void displayQuiz(const Quiz& quiz) {
     }
 }
 
+// Name of the checkpoint file holding a student's in-progress answers for a quiz
+string checkpointFilename(const string& courseID, const string& username, const string& quizName) {
+    return courseID + "_" + username + "_" + quizName + ".ckpt";
+}
+
+// FNV-1a hash of the quiz contents, so a checkpoint can tell if the quiz was modified
+unsigned long quizFingerprint(const Quiz& quiz) {
+    ostringstream content;
+    content << quiz.numQuestions << '\n';
+    for (int i = 0; i < quiz.numQuestions; ++i) {
+        content << quiz.questions[i].questionText << '\n';
+        for (int j = 0; j < 4; ++j) {
+            content << quiz.questions[i].options[j] << '\n';
+        }
+        content << quiz.questions[i].correctAnswerIndex << '\n';
+    }
+
+    string text = content.str();
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < text.size(); ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Implementation of readCheckpoint function
+// The checkpoint starts with a "<numQuestions> <fingerprint>" header line, followed by
+// one character ('1'-'4') per answered question, in order.
+// Returns the number of answers recovered into answers[] (0 if there is no usable checkpoint).
+int readCheckpoint(const string& filename, const Quiz& quiz, int answers[]) {
+    ifstream infile(filename.c_str());
+    if (!infile.is_open()) {
+        return 0; // No checkpoint, quiz starts from the beginning
+    }
+
+    int numQuestions = -1;
+    unsigned long fingerprint = 0;
+    infile >> numQuestions >> fingerprint;
+    infile.ignore(); // Consume newline character after the header
+    if (!infile) {
+        // Empty or damaged header, e.g. the process died before it was written
+        infile.close();
+        return 0;
+    }
+    if (numQuestions != quiz.numQuestions || fingerprint != quizFingerprint(quiz)) {
+        // Answers were given to a different version of the quiz, they cannot be reused
+        cout << "Quiz " << quiz.name << " was modified since your last attempt, starting again." << endl;
+        infile.close();
+        return 0;
+    }
+
+    int count = 0;
+    char c;
+    while (count < numQuestions && infile.get(c)) {
+        if (c < '1' || c > '4') {
+            break; // Stop at the first damaged entry
+        }
+        answers[count++] = c - '1';
+    }
+
+    infile.close();
+    return count;
+}
 
 double Quiz::calculateGrade(const int answers[]) const {
     int correctAnswers = 0;
@@ -295,20 +916,48 @@ void Student::takeQuiz(const Quiz& quiz, const User& user) {
     quiz.displayQuiz();
 
     // Prepare variables to store student's answers
-    int answers[quiz.numQuestions];
+    int* answers = new int[quiz.numQuestions];
+
+    // Resume from the checkpoint if a previous attempt was interrupted
+    string checkpoint = checkpointFilename(user.getCourseID(), user.getUsername(), quiz.name);
+    int answered = readCheckpoint(checkpoint, quiz, answers);
+    if (answered == quiz.numQuestions) {
+        cout << "All answers recovered from your previous attempt" << endl;
+    } else if (answered > 0) {
+        cout << "Resuming quiz from question " << (answered + 1) << endl;
+    }
+
+    // Rewrite the header and recovered answers so a damaged tail is dropped, then keep
+    // the file open and append one byte per answer. Flushing hands each answer to the
+    // OS (a single small write), so it survives the process dying without an fsync.
+    ofstream ckptfile(checkpoint.c_str(), ios::out | ios::trunc);
+    if (!ckptfile.is_open()) {
+        cerr << "Warning: Could not open " << checkpoint << ", your answers will not be saved until the quiz is finished." << endl;
+    }
+    ckptfile << quiz.numQuestions << " " << quizFingerprint(quiz) << '\n';
+    for (int i = 0; i < answered; ++i) {
+        ckptfile.put(static_cast<char>('1' + answers[i]));
+    }
+    ckptfile.flush();
 
     // Get student's answer for each question
-    for (int i = 0; i < quiz.numQuestions; ++i) {
+    for (int i = answered; i < quiz.numQuestions; ++i) {
         int answer;
         do {
             cout << "Enter your answer for question " << (i + 1) << " (1-4): ";
             cin >> answer;
         } while (answer < 1 || answer > 4);
         answers[i] = answer - 1; // Adjust for zero-based indexing
+
+        // Checkpoint the answer as soon as it is entered
+        ckptfile.put(static_cast<char>('0' + answer));
+        ckptfile.flush();
     }
+    ckptfile.close();
 
     // Calculate the student's grade (call calculateGrade from Quiz)
     double grade = quiz.calculateGrade(answers);
+    delete[] answers;
 
     // Display the grade
     cout << "Your grade for " << quiz.name << " is: " << grade << "%" << endl;
@@ -320,6 +969,8 @@ void Student::takeQuiz(const Quiz& quiz, const User& user) {
 
     if (writefile.is_open()) {
         writefile << quiz.name << "," << grade << "%" << endl;
+        writefile.close();
+        remove(checkpoint.c_str()); // Attempt recorded, checkpoint no longer needed
     }
 }
 
@@ -472,6 +1123,12 @@ int main() {
 
     int choice, choice_2;
 
+    // Upgrade any passwords stored with the old scheme before anyone logs in
+    migrateUserData(userFilename);
+
+    // Remembers recent logins so logging in again skips the KDF
+    LoginCache logins(envSetting("QMS_LOGIN_TTL", 300));
+
     // Loop to display menu until user quits
     do {
         system("cls"); // Clear the console for a clean look
@@ -495,7 +1152,13 @@ int main() {
             cout << "\t\tEnter password: ";
             cin >> password;
 
-            User user = readUserData(userFilename, username, password);
+            User user;
+            if (!logins.lookup(username, password, user)) {
+                user = readUserData(userFilename, username, password);
+                if (!user.getUsername().empty()) {
+                    logins.store(user, password);
+                }
+            }
             if (user.getUsername().empty()) {
                 cout << "\n\t\tInvalid username or password." << endl;
                 system("pause"); // Pause for the user to see the error